@@ -25,5 +25,5 @@ make -j$(nproc)
 echo "Build completed successfully!"
 echo "Executable: build/benchmark"
 echo ""
-echo "Usage: ./benchmark <input_width> <input_height> <output_width> <output_height> <iterations>"
+echo "Usage: ./benchmark <input_width> <input_height> <output_width> <output_height> <iterations> [--streams N] [--workers M] [--power] [--soak SECONDS]"
 echo "Example: ./benchmark 1920 1080 640 480 100"
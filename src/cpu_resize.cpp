@@ -1,8 +1,11 @@
 #include "cpu_resize.h"
 #include <cmath>
 #include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-CPUResize::CPUResize() {}
+CPUResize::CPUResize(int num_threads) : m_num_threads(num_threads) {}
 
 CPUResize::~CPUResize() {}
 
@@ -13,7 +16,11 @@ void CPUResize::resize(const float* input, float* output,
     float x_ratio = (float)(input_width - 1) / output_width;
     float y_ratio = (float)(input_height - 1) / output_height;
 
-    #pragma omp parallel for collapse(2)
+#ifdef _OPENMP
+    int num_threads = m_num_threads > 0 ? m_num_threads : omp_get_max_threads();
+#endif
+
+    #pragma omp parallel for collapse(2) num_threads(num_threads)
     for (int y = 0; y < output_height; y++) {
         for (int x = 0; x < output_width; x++) {
             int x_l = (int)(x_ratio * x);
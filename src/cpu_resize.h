@@ -2,10 +2,15 @@
 
 class CPUResize {
 public:
-    CPUResize();
+    // num_threads <= 0 uses the OpenMP default team size. Set it when several
+    // instances run concurrently so they don't oversubscribe the cores.
+    explicit CPUResize(int num_threads = 0);
     ~CPUResize();
 
     void resize(const float* input, float* output,
                 int input_width, int input_height,
                 int output_width, int output_height);
+
+private:
+    int m_num_threads;
 };
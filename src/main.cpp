@@ -2,9 +2,24 @@
 #include <vector>
 #include <memory>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <string>
+#include <thread>
 #include "timer.h"
 #include "image_utils.h"
 #include "cpu_resize.h"
+#include "resize_service.h"
+#include "power_monitor.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef USE_OPENCL
 #include "opencl_resize.h"
@@ -16,8 +31,15 @@
 
 void print_usage(const char* prog_name) {
     std::cout << "Usage: " << prog_name 
-              << " <input_width> <input_height> <output_width> <output_height> <iterations>\n";
+              << " <input_width> <input_height> <output_width> <output_height> <iterations>"
+              << " [--streams N] [--workers M] [--power] [--soak SECONDS]\n";
+    std::cout << "  --streams N   Also run the multi-stream benchmark, scaling producers 1..N\n";
+    std::cout << "  --workers M   Worker queues in the multi-stream resize service (default: 2)\n";
+    std::cout << "  --power       Sample frequencies, temperatures and power during each run\n";
+    std::cout << "  --soak S      Also run each backend for S seconds, reporting sustained vs burst FPS\n";
     std::cout << "Example: " << prog_name << " 1920 1080 640 480 100\n";
+    std::cout << "Example: " << prog_name << " 1920 1080 640 480 100 --streams 16 --workers 4\n";
+    std::cout << "Example: " << prog_name << " 1920 1080 640 480 100 --power --soak 600\n";
 }
 
 void print_results(const std::string& name, double total_time, int iterations) {
@@ -29,8 +51,340 @@ void print_results(const std::string& name, double total_time, int iterations) {
     std::cout << "  FPS: " << (1000.0 / avg_time) << "\n\n";
 }
 
+void print_power_sources(const PowerMonitor& monitor) {
+    std::cout << "Power/thermal sources:\n";
+    for (const auto& name : monitor.freq_domains()) {
+        std::cout << "  freq:  " << name << "\n";
+    }
+    for (const auto& name : monitor.thermal_zones()) {
+        std::cout << "  temp:  " << name << "\n";
+    }
+    std::cout << "  power: " << (monitor.has_power() ? monitor.power_source() : "not available") << "\n";
+    if (monitor.freq_domains().empty() && monitor.thermal_zones().empty()) {
+        std::cout << "  (no cpufreq/devfreq/thermal sysfs nodes found)\n";
+    }
+    std::cout << "\n";
+}
+
+// Frequencies, perf-per-GHz, throttling, temperatures and frames per joule
+// for `frames` resized during the summarized window.
+void print_power_report(const PowerMonitor& monitor, const PowerSummary& summary, long frames) {
+    double fps = summary.duration_ms > 0.0 ? frames * 1000.0 / summary.duration_ms : 0.0;
+
+    std::vector<std::string> unpinned;
+    bool boosted = false;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  Power/thermal:\n";
+    for (size_t d = 0; d < monitor.freq_domains().size(); d++) {
+        double avg = summary.avg_freq_mhz[d];
+        if (std::isnan(avg)) continue;
+        std::cout << "    " << std::left << std::setw(24) << monitor.freq_domains()[d] << std::right
+                  << " avg " << std::setw(7) << avg << " MHz"
+                  << " (min " << summary.min_freq_mhz[d] << ", max " << summary.max_freq_mhz[d] << ")"
+                  << "  FPS/GHz " << (avg > 0.0 ? fps / (avg / 1000.0) : 0.0) << "\n";
+
+        double ceiling = monitor.freq_ceilings()[d];
+        const std::string& governor = monitor.freq_governors()[d];
+        std::cout << "    " << std::setw(24) << ""
+                  << " throttle events " << summary.throttle_events[d]
+                  << ", " << summary.below_ceiling_pct[d] << "% of time below ";
+        if (std::isnan(ceiling)) {
+            std::cout << "peak (ceiling not exposed)";
+        } else {
+            std::cout << "ceiling " << ceiling << " MHz";
+        }
+        if (monitor.ceiling_includes_boost()[d]) {
+            std::cout << " incl. boost";
+        }
+        if (!governor.empty()) {
+            std::cout << " [" << governor << "]";
+        }
+        std::cout << "\n";
+        // Any other governor lowers clocks when idle, which is not throttling
+        if (governor != "performance") {
+            unpinned.push_back(monitor.freq_domains()[d]);
+        }
+        if (monitor.ceiling_includes_boost()[d]) {
+            boosted = true;
+        }
+    }
+    if (!unpinned.empty()) {
+        std::cout << "    note: throttle counts assume a pinned performance governor"
+                  << " (scripts/set_perf_mode.sh performance); not pinned:";
+        for (const auto& name : unpinned) {
+            std::cout << " " << name;
+        }
+        std::cout << "\n";
+    }
+    if (boosted) {
+        std::cout << "    note: ceilings marked \"incl. boost\" are single-core boost clocks;"
+                  << " running below them under all-core load counts as throttling\n";
+    }
+    for (size_t z = 0; z < monitor.thermal_zones().size(); z++) {
+        if (std::isnan(summary.avg_temp_c[z])) continue;
+        std::cout << "    " << std::left << std::setw(24) << monitor.thermal_zones()[z] << std::right
+                  << " avg " << std::setw(7) << summary.avg_temp_c[z] << " C"
+                  << "   (max " << summary.max_temp_c[z] << ")\n";
+    }
+    std::cout << std::setprecision(3);
+    if (summary.energy_j >= 0.0) {
+        std::cout << "    Energy: " << summary.energy_j << " J, avg power "
+                  << summary.avg_power_w << " W, "
+                  << (summary.energy_j > 0.0 ? frames / summary.energy_j : 0.0)
+                  << " frames/J (" << monitor.power_source() << ")\n";
+    } else {
+        std::cout << "    Energy: not available\n";
+    }
+    std::cout << "\n";
+}
+
+// Wrap `count` independent resizer instances as ResizeService workers.
+template <typename Resizer, typename Factory>
+std::vector<ResizeService::ResizeFn> make_service_workers(int count, Factory create) {
+    std::vector<ResizeService::ResizeFn> workers;
+    for (int i = 0; i < count; i++) {
+        std::shared_ptr<Resizer> resizer = create();
+        workers.push_back([resizer](const float* input, float* output,
+                                    int input_width, int input_height,
+                                    int output_width, int output_height) {
+            resizer->resize(input, output, input_width, input_height,
+                            output_width, output_height);
+        });
+    }
+    return workers;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t idx = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+// Feed a ResizeService from 1, 2, 4, ... max_streams producer threads (one
+// stream each) and report aggregate throughput, latency percentiles and the
+// per-stream FPS spread. With more than one stream, stream 0 is greedy: it
+// keeps twice the per-stream queue depth in flight, so its queue stays full
+// and round-robin scheduling has to keep it from starving the others.
+void run_multistream_benchmark(const std::string& name,
+                               const std::vector<ResizeService::ResizeFn>& workers,
+                               const std::vector<float>& input_image,
+                               int input_width, int input_height,
+                               int output_width, int output_height,
+                               int frames_per_stream, int max_streams,
+                               PowerMonitor* monitor) {
+    // Frames each producer keeps in flight (double buffering)
+    const int frames_in_flight = 2;
+    const size_t queue_depth = 8;
+    const int greedy_in_flight = 2 * (int)queue_depth;
+    const int warmup_frames = 5;
+    size_t output_size = (size_t)output_width * output_height * 3;
+
+    // Warm every backend directly, before any service exists, so each
+    // worker's first-launch cost (queue/kernel setup) stays out of the
+    // timed rows. Nothing else calls these backends yet, so this is safe.
+    {
+        std::vector<float> scratch(output_size);
+        for (const auto& resize : workers) {
+            for (int i = 0; i < warmup_frames; i++) {
+                resize(input_image.data(), scratch.data(),
+                       input_width, input_height, output_width, output_height);
+            }
+        }
+    }
+
+    std::vector<int> producer_counts;
+    for (int n = 1; n < max_streams; n *= 2) {
+        producer_counts.push_back(n);
+    }
+    producer_counts.push_back(max_streams);
+
+    std::cout << name << " multi-stream (" << workers.size() << " workers, "
+              << frames_per_stream << " frames/stream):\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  streams   total ms        FPS    p50 ms    p95 ms    p99 ms    max ms"
+              << "   stream FPS min/max   greedy FPS\n";
+
+    // With --power, one summary per row, printed after the table
+    std::vector<PowerSummary> power_summaries;
+    std::vector<long> power_frames;
+
+    for (int producers : producer_counts) {
+        ResizeService service(workers, producers, queue_depth);
+
+        std::vector<std::vector<double>> latencies(producers);
+        std::vector<double> finish_ms(producers, 0.0);
+        std::vector<std::exception_ptr> errors(producers);
+        std::vector<std::thread> threads;
+
+        if (monitor) monitor->start();
+        Timer timer;
+        timer.start();
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                int depth = (p == 0 && producers > 1) ? greedy_in_flight : frames_in_flight;
+                std::vector<std::vector<float>> outputs(depth, std::vector<float>(output_size));
+                std::vector<std::future<double>> inflight(depth);
+                latencies[p].reserve(frames_per_stream);
+                try {
+                    for (int i = 0; i < frames_per_stream; i++) {
+                        int slot = i % depth;
+                        if (inflight[slot].valid()) {
+                            latencies[p].push_back(inflight[slot].get());
+                        }
+                        inflight[slot] = service.submit(p, input_image.data(), outputs[slot].data(),
+                                                        input_width, input_height,
+                                                        output_width, output_height);
+                    }
+                    for (auto& f : inflight) {
+                        if (f.valid()) latencies[p].push_back(f.get());
+                    }
+                    finish_ms[p] = timer.elapsed();
+                } catch (...) {
+                    errors[p] = std::current_exception();
+                    // Outputs must outlive any frame still queued
+                    for (auto& f : inflight) {
+                        if (f.valid()) f.wait();
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        double total_time = timer.stop();
+        if (monitor) monitor->stop();
+        service.shutdown();
+
+        for (auto& e : errors) {
+            if (e) std::rethrow_exception(e);
+        }
+
+        std::vector<double> all;
+        for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+        std::sort(all.begin(), all.end());
+
+        if (monitor) {
+            power_summaries.push_back(monitor->summarize());
+            power_frames.push_back((long)all.size());
+        }
+
+        std::cout << std::setw(9) << producers
+                  << std::setw(11) << total_time
+                  << std::setw(11) << (all.size() * 1000.0 / total_time)
+                  << std::setw(10) << percentile(all, 50)
+                  << std::setw(10) << percentile(all, 95)
+                  << std::setw(10) << percentile(all, 99)
+                  << std::setw(10) << (all.empty() ? 0.0 : all.back());
+
+        // Each stream's rate up to its own last completion; a fair scheduler
+        // keeps these close even with the greedy stream present
+        std::vector<double> stream_fps(producers);
+        for (int p = 0; p < producers; p++) {
+            stream_fps[p] = finish_ms[p] > 0.0 ? latencies[p].size() * 1000.0 / finish_ms[p] : 0.0;
+        }
+        auto minmax = std::minmax_element(stream_fps.begin(), stream_fps.end());
+        std::cout << std::setw(11) << *minmax.first << std::setw(10) << *minmax.second;
+        if (producers > 1) {
+            std::cout << std::setw(13) << stream_fps[0] << "\n";
+        } else {
+            std::cout << std::setw(13) << "-" << "\n";
+        }
+    }
+    std::cout << "\n";
+
+    for (size_t i = 0; i < power_summaries.size(); i++) {
+        std::cout << name << " multi-stream, " << producer_counts[i] << " stream(s):\n";
+        print_power_report(*monitor, power_summaries[i], power_frames[i]);
+    }
+}
+
+// Run `resize_once` back to back for `seconds`, bucketing throughput into
+// windows to show how sustained performance compares with the initial burst.
+// Burst is measured over a fixed short window so long soaks don't average
+// early throttling into it.
+void run_soak_benchmark(const std::string& name, const std::function<void()>& resize_once,
+                        int seconds, PowerMonitor& monitor) {
+    const double duration_ms = seconds * 1000.0;
+    const double window_ms = std::max(1000.0, duration_ms / 30.0);
+    const int bar_width = 40;
+    const double burst_ms = 2000.0;
+
+    struct Window {
+        double begin_ms;
+        double end_ms;
+        long frames;
+    };
+    std::vector<Window> windows;
+
+    std::cout << "Running " << name << " soak test (" << seconds << " s)...\n";
+    monitor.start();
+    double begin = monitor.elapsed_ms();
+    long frames = 0;
+    long frames_so_far = 0;
+    double burst_fps = -1.0;
+    for (;;) {
+        resize_once();
+        frames++;
+        frames_so_far++;
+        double now = monitor.elapsed_ms();
+        if (burst_fps < 0.0 && now >= burst_ms) {
+            burst_fps = frames_so_far * 1000.0 / now;
+        }
+        if (now - begin >= window_ms) {
+            windows.push_back({begin, now, frames});
+            begin = now;
+            frames = 0;
+            if (now >= duration_ms) break;
+        }
+    }
+    monitor.stop();
+
+    std::vector<double> fps;
+    long total_frames = 0;
+    for (const auto& w : windows) {
+        fps.push_back(w.frames * 1000.0 / (w.end_ms - w.begin_ms));
+        total_frames += w.frames;
+    }
+    double peak_fps = *std::max_element(fps.begin(), fps.end());
+
+    std::cout << name << " soak:\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "      time       FPS   max C\n";
+    for (size_t i = 0; i < windows.size(); i++) {
+        PowerSummary ws = monitor.summarize(windows[i].begin_ms, windows[i].end_ms);
+        double max_temp = std::numeric_limits<double>::quiet_NaN();
+        for (double t : ws.max_temp_c) {
+            if (!std::isnan(t)) max_temp = std::isnan(max_temp) ? t : std::max(max_temp, t);
+        }
+        int bar = peak_fps > 0.0 ? (int)(fps[i] / peak_fps * bar_width + 0.5) : 0;
+        std::cout << std::setw(9) << windows[i].begin_ms / 1000.0 << "s"
+                  << std::setw(10) << fps[i];
+        if (std::isnan(max_temp)) {
+            std::cout << "     n/a";
+        } else {
+            std::cout << std::setw(8) << max_temp;
+        }
+        std::cout << "  " << std::string(bar, '#') << "\n";
+    }
+
+    // Burst = first burst_ms; sustained = mean of the last quarter of windows
+    if (burst_fps < 0.0) {
+        burst_fps = fps.front();
+    }
+    size_t tail = std::max<size_t>(1, fps.size() / 4);
+    double sustained = 0.0;
+    for (size_t i = fps.size() - tail; i < fps.size(); i++) {
+        sustained += fps[i];
+    }
+    sustained /= tail;
+    std::cout << "  Burst FPS (first " << burst_ms / 1000.0 << " s): " << burst_fps
+              << ", sustained FPS: " << sustained
+              << " (" << (burst_fps > 0.0 ? sustained / burst_fps * 100.0 : 0.0) << "% of burst)\n";
+
+    print_power_report(monitor, monitor.summarize(), total_frames);
+}
+
 int main(int argc, char** argv) {
-    if (argc != 6) {
+    if (argc < 6) {
         print_usage(argv[0]);
         return 1;
     }
@@ -41,6 +395,38 @@ int main(int argc, char** argv) {
     int output_height = std::atoi(argv[4]);
     int iterations = std::atoi(argv[5]);
 
+    // Optional flags
+    int max_streams = 0;
+    int num_workers = 2;
+    bool power = false;
+    int soak_seconds = 0;
+    for (int i = 6; i < argc; i++) {
+        if (std::strcmp(argv[i], "--streams") == 0 && i + 1 < argc) {
+            max_streams = std::atoi(argv[++i]);
+            if (max_streams <= 0) {
+                std::cerr << "Error: --streams must be a positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            num_workers = std::atoi(argv[++i]);
+            if (num_workers <= 0) {
+                std::cerr << "Error: --workers must be a positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--power") == 0) {
+            power = true;
+        } else if (std::strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+            soak_seconds = std::atoi(argv[++i]);
+            if (soak_seconds <= 0) {
+                std::cerr << "Error: --soak must be a positive number of seconds\n";
+                return 1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
     if (input_width <= 0 || input_height <= 0 || 
         output_width <= 0 || output_height <= 0 || iterations <= 0) {
         std::cerr << "Error: All parameters must be positive integers\n";
@@ -50,7 +436,20 @@ int main(int argc, char** argv) {
     std::cout << "=== SYCL vs OpenCL vs CPU Benchmark on RK3588 ===\n";
     std::cout << "Input size: " << input_width << "x" << input_height << "\n";
     std::cout << "Output size: " << output_width << "x" << output_height << "\n";
-    std::cout << "Iterations: " << iterations << "\n\n";
+    std::cout << "Iterations: " << iterations << "\n";
+    if (max_streams > 0) {
+        std::cout << "Multi-stream: up to " << max_streams << " streams, "
+                  << num_workers << " workers\n";
+    }
+    if (soak_seconds > 0) {
+        std::cout << "Soak duration: " << soak_seconds << " s\n";
+    }
+    std::cout << "\n";
+
+    PowerMonitor monitor;
+    if (power || soak_seconds > 0) {
+        print_power_sources(monitor);
+    }
 
     // Generate test image
     std::cout << "Generating test image...\n";
@@ -74,6 +473,7 @@ int main(int argc, char** argv) {
         }
 
         // Benchmark
+        if (power) monitor.start();
         Timer timer;
         timer.start();
         for (int i = 0; i < iterations; i++) {
@@ -82,7 +482,35 @@ int main(int argc, char** argv) {
                              output_width, output_height);
         }
         double cpu_time = timer.stop();
+        if (power) monitor.stop();
         print_results("CPU (OpenMP)", cpu_time, iterations);
+        if (power) print_power_report(monitor, monitor.summarize(), iterations);
+
+        if (max_streams > 0) {
+            // Split the OpenMP threads between workers instead of giving each
+            // worker a full team, which would only measure oversubscription
+            int threads_per_worker = 1;
+#ifdef _OPENMP
+            threads_per_worker = std::max(1, omp_get_max_threads() / num_workers);
+#endif
+            auto workers = make_service_workers<CPUResize>(num_workers, [&] {
+                return std::make_unique<CPUResize>(threads_per_worker);
+            });
+            run_multistream_benchmark("CPU (OpenMP, " + std::to_string(threads_per_worker) +
+                                      " threads/worker)", workers, input_image,
+                                      input_width, input_height,
+                                      output_width, output_height,
+                                      iterations, max_streams,
+                                      power ? &monitor : nullptr);
+        }
+
+        if (soak_seconds > 0) {
+            run_soak_benchmark("CPU (OpenMP)", [&] {
+                cpu_resizer.resize(input_image.data(), output_image.data(),
+                                   input_width, input_height,
+                                   output_width, output_height);
+            }, soak_seconds, monitor);
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "CPU Error: " << e.what() << "\n";
@@ -103,6 +531,7 @@ int main(int argc, char** argv) {
 
         // Benchmark
         std::cout << "Running OpenCL benchmark...\n";
+        if (power) monitor.start();
         Timer timer;
         timer.start();
         for (int i = 0; i < iterations; i++) {
@@ -111,7 +540,31 @@ int main(int argc, char** argv) {
                                 output_width, output_height);
         }
         double opencl_time = timer.stop();
+        if (power) monitor.stop();
         print_results("OpenCL", opencl_time, iterations);
+        if (power) print_power_report(monitor, monitor.summarize(), iterations);
+
+        if (max_streams > 0) {
+            auto workers = make_service_workers<OpenCLResize>(num_workers, [&] {
+                return opencl_resizer.create_worker();
+            });
+            run_multistream_benchmark("OpenCL", workers, input_image,
+                                      input_width, input_height,
+                                      output_width, output_height,
+                                      iterations, max_streams,
+                                      power ? &monitor : nullptr);
+        }
+
+        if (soak_seconds > 0) {
+            // A per-frame print would flood the output and skew the measured FPS
+            opencl_resizer.set_report_kernel_time(false);
+            run_soak_benchmark("OpenCL", [&] {
+                opencl_resizer.resize(input_image.data(), output_image.data(),
+                                      input_width, input_height,
+                                      output_width, output_height);
+            }, soak_seconds, monitor);
+            opencl_resizer.set_report_kernel_time(true);
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "OpenCL Error: " << e.what() << "\n";
@@ -143,6 +596,7 @@ int main(int argc, char** argv) {
 
         // Benchmark
         std::cout << "Running SYCL benchmark...\n";
+        if (power) monitor.start();
         Timer timer;
         timer.start();
         for (int i = 0; i < iterations; i++) {
@@ -151,7 +605,28 @@ int main(int argc, char** argv) {
                               output_width, output_height);
         }
         double sycl_time = timer.stop();
+        if (power) monitor.stop();
         print_results("SYCL (AdaptiveCpp)", sycl_time, iterations);
+        if (power) print_power_report(monitor, monitor.summarize(), iterations);
+
+        if (max_streams > 0) {
+            auto workers = make_service_workers<SYCLResize>(num_workers, [&] {
+                return sycl_resizer.create_worker();
+            });
+            run_multistream_benchmark("SYCL (AdaptiveCpp)", workers, input_image,
+                                      input_width, input_height,
+                                      output_width, output_height,
+                                      iterations, max_streams,
+                                      power ? &monitor : nullptr);
+        }
+
+        if (soak_seconds > 0) {
+            run_soak_benchmark("SYCL (AdaptiveCpp)", [&] {
+                sycl_resizer.resize(input_image.data(), output_image.data(),
+                                    input_width, input_height,
+                                    output_width, output_height);
+            }, soak_seconds, monitor);
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "SYCL Error: " << e.what() << "\n";
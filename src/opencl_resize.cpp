@@ -15,10 +15,36 @@
 OpenCLResize::OpenCLResize() 
     : m_platform(nullptr), m_device(nullptr), m_context(nullptr),
       m_queue(nullptr), m_program(nullptr), m_kernel(nullptr),
-      m_initialized(false) {
+      m_initialized(false), m_report_kernel_time(true) {
     init_opencl();
 }
 
+OpenCLResize::OpenCLResize(const OpenCLResize& parent, WorkerTag)
+    : m_platform(parent.m_platform), m_device(parent.m_device),
+      m_context(parent.m_context), m_queue(nullptr),
+      m_program(parent.m_program), m_kernel(nullptr),
+      m_initialized(false), m_report_kernel_time(false) {
+    if (!parent.m_initialized) {
+        throw std::runtime_error("OpenCL not initialized");
+    }
+
+    // Shared objects are reference counted; cleanup() releases them again
+    clRetainContext(m_context);
+    clRetainProgram(m_program);
+
+    try {
+        create_queue_and_kernel();
+    } catch (...) {
+        cleanup();
+        throw;
+    }
+    m_initialized = true;
+}
+
+std::unique_ptr<OpenCLResize> OpenCLResize::create_worker() const {
+    return std::unique_ptr<OpenCLResize>(new OpenCLResize(*this, WorkerTag{}));
+}
+
 OpenCLResize::~OpenCLResize() {
     cleanup();
 }
@@ -63,11 +89,6 @@ void OpenCLResize::init_opencl() {
     m_context = clCreateContext(nullptr, 1, &m_device, nullptr, nullptr, &err);
     CHECK_CL_ERROR(err, "Failed to create OpenCL context");
 
-    // Create command queue
-    // Enable profiling to measure kernel execution time
-    m_queue = clCreateCommandQueue(m_context, m_device, CL_QUEUE_PROFILING_ENABLE, &err);
-    CHECK_CL_ERROR(err, "Failed to create command queue");
-
     // Load and compile kernel
     std::string kernel_source = load_kernel_source("kernels/resize.cl");
     const char* source_str = kernel_source.c_str();
@@ -86,12 +107,24 @@ void OpenCLResize::init_opencl() {
         throw std::runtime_error("Failed to build program");
     }
 
-    m_kernel = clCreateKernel(m_program, "resize_bilinear", &err);
-    CHECK_CL_ERROR(err, "Failed to create kernel");
+    create_queue_and_kernel();
 
     m_initialized = true;
 }
 
+void OpenCLResize::create_queue_and_kernel() {
+    cl_int err;
+
+    // Create command queue
+    // Enable profiling to measure kernel execution time
+    m_queue = clCreateCommandQueue(m_context, m_device, CL_QUEUE_PROFILING_ENABLE, &err);
+    CHECK_CL_ERROR(err, "Failed to create command queue");
+
+    // Kernel objects hold their arguments, so every queue needs its own
+    m_kernel = clCreateKernel(m_program, "resize_bilinear", &err);
+    CHECK_CL_ERROR(err, "Failed to create kernel");
+}
+
 void OpenCLResize::cleanup() {
     if (m_kernel) clReleaseKernel(m_kernel);
     if (m_program) clReleaseProgram(m_program);
@@ -140,11 +173,13 @@ void OpenCLResize::resize(const float* input, float* output,
     CHECK_CL_ERROR(err, "Failed to execute kernel");
 
     clWaitForEvents(1, &event);
-    cl_ulong start = 0, end = 0;
-    clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr);
-    clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr);
-    double kernel_time = (double)(end - start) / 1000000.0;
-    std::cout << "Kernel time: " << kernel_time << " ms" << std::endl;
+    if (m_report_kernel_time) {
+        cl_ulong start = 0, end = 0;
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &start, nullptr);
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &end, nullptr);
+        double kernel_time = (double)(end - start) / 1000000.0;
+        std::cout << "Kernel time: " << kernel_time << " ms" << std::endl;
+    }
     clReleaseEvent(event);
 
     // Read results
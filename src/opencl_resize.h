@@ -5,6 +5,7 @@
 
 #define CL_TARGET_OPENCL_VERSION 120
 #include <CL/cl.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -13,12 +14,28 @@ public:
     OpenCLResize();
     ~OpenCLResize();
 
+    OpenCLResize(const OpenCLResize&) = delete;
+    OpenCLResize& operator=(const OpenCLResize&) = delete;
+
+    // Create a resizer that shares this instance's context and built program
+    // but has its own command queue and cl_kernel, so it can be driven from
+    // another thread without racing on clSetKernelArg. Workers do not print
+    // per-call kernel times, which would interleave across threads.
+    std::unique_ptr<OpenCLResize> create_worker() const;
+
+    // Print the profiled kernel time after every resize() (default: on)
+    void set_report_kernel_time(bool enable) { m_report_kernel_time = enable; }
+
     void resize(const float* input, float* output,
                int input_width, int input_height,
                int output_width, int output_height);
 
 private:
+    struct WorkerTag {};
+    OpenCLResize(const OpenCLResize& parent, WorkerTag);
+
     void init_opencl();
+    void create_queue_and_kernel();
     void cleanup();
     std::string load_kernel_source(const char* filename);
 
@@ -30,6 +47,7 @@ private:
     cl_kernel m_kernel;
     
     bool m_initialized;
+    bool m_report_kernel_time;
 };
 
 #endif // USE_OPENCL
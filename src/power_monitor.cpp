@@ -0,0 +1,390 @@
+#include "power_monitor.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// cur_freq rarely lands exactly on the advertised maximum
+const double kCeilingTolerance = 0.98;
+
+bool read_value(const std::string& path, double& value) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    return static_cast<bool>(file >> value);
+}
+
+std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// Largest value in a whitespace-separated list such as available_frequencies
+bool read_max_value(const std::string& path, double& value) {
+    std::ifstream file(path);
+    double v;
+    bool found = false;
+    while (file >> v) {
+        value = found ? std::max(value, v) : v;
+        found = true;
+    }
+    return found;
+}
+
+// Sorted entries of `dir` whose names start with `prefix`; empty if the
+// directory does not exist or is not readable.
+std::vector<std::string> list_dir(const std::string& dir, const std::string& prefix) {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            names.push_back(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // namespace
+
+PowerMonitor::PowerMonitor(int interval_ms)
+    : m_interval_ms(interval_ms), m_power_sensor{"", 0.0},
+      m_last_power_w(0.0), m_energy_j(0.0), m_last_time_ms(0.0),
+      m_running(false) {
+    discover();
+}
+
+PowerMonitor::~PowerMonitor() {
+    stop();
+}
+
+void PowerMonitor::discover() {
+    double value;
+
+    // CPU clusters (RK3588: policy0 = A55, policy4/policy6 = A76), kHz
+    const std::string cpufreq = "/sys/devices/system/cpu/cpufreq/";
+    double boost_enabled = 0.0;
+    double no_turbo = 1.0;
+    bool boost = (read_value(cpufreq + "boost", boost_enabled) && boost_enabled != 0.0) ||
+                 (read_value("/sys/devices/system/cpu/intel_pstate/no_turbo", no_turbo) &&
+                  no_turbo == 0.0);
+    for (const auto& policy : list_dir(cpufreq, "policy")) {
+        std::string path = cpufreq + policy + "/scaling_cur_freq";
+        if (read_value(path, value)) {
+            // Prefer a non-boost maximum: the base frequency (intel_pstate,
+            // amd-pstate), else the highest regular OPP (cpufreq-dt lists
+            // boost OPPs separately). cpuinfo_max_freq includes boost clocks
+            // when enabled; scaling_max_freq is what thermal capping lowers,
+            // so it is only the last resort.
+            double ceiling = kNaN;
+            bool ceiling_boost = false;
+            if (read_value(cpufreq + policy + "/base_frequency", value) ||
+                read_value(cpufreq + policy + "/amd_pstate_nominal_freq", value) ||
+                read_max_value(cpufreq + policy + "/scaling_available_frequencies", value)) {
+                ceiling = value * 1e-3;
+            } else if (read_value(cpufreq + policy + "/cpuinfo_max_freq", value) ||
+                       read_value(cpufreq + policy + "/scaling_max_freq", value)) {
+                ceiling = value * 1e-3;
+                ceiling_boost = boost;
+            }
+            m_freq_sources.push_back({path, 1e-3});
+            m_freq_names.push_back("cpu/" + policy);
+            m_freq_ceilings.push_back(ceiling);
+            m_freq_ceiling_boost.push_back(ceiling_boost);
+            m_freq_governors.push_back(read_line(cpufreq + policy + "/scaling_governor"));
+        }
+    }
+
+    // GPU, NPU, DMC etc. (RK3588 Mali: fb000000.gpu), Hz
+    const std::string devfreq = "/sys/class/devfreq/";
+    for (const auto& dev : list_dir(devfreq, "")) {
+        std::string path = devfreq + dev + "/cur_freq";
+        if (read_value(path, value)) {
+            // Highest OPP; max_freq can already be reduced by thermal QoS
+            double ceiling = kNaN;
+            if (read_max_value(devfreq + dev + "/available_frequencies", value) ||
+                read_value(devfreq + dev + "/max_freq", value)) {
+                ceiling = value * 1e-6;
+            }
+            m_freq_sources.push_back({path, 1e-6});
+            m_freq_names.push_back("devfreq/" + dev);
+            m_freq_ceilings.push_back(ceiling);
+            m_freq_ceiling_boost.push_back(false);
+            m_freq_governors.push_back(read_line(devfreq + dev + "/governor"));
+        }
+    }
+
+    // millidegrees Celsius
+    const std::string thermal = "/sys/class/thermal/";
+    for (const auto& zone : list_dir(thermal, "thermal_zone")) {
+        std::string path = thermal + zone + "/temp";
+        if (read_value(path, value)) {
+            std::string type = read_line(thermal + zone + "/type");
+            m_temp_sources.push_back({path, 1e-3});
+            m_temp_names.push_back(type.empty() ? zone : type);
+        }
+    }
+
+    // RAPL package counters (intel-rapl:N, not the intel-rapl:N:M subzones
+    // which are already included in the package), microjoules. energy_uj is
+    // root-only on recent kernels, in which case this finds nothing.
+    const std::string powercap = "/sys/class/powercap/";
+    for (const auto& zone : list_dir(powercap, "intel-rapl:")) {
+        if (std::count(zone.begin(), zone.end(), ':') != 1) {
+            continue;
+        }
+        std::string path = powercap + zone + "/energy_uj";
+        if (read_value(path, value)) {
+            double range = 0.0;
+            read_value(powercap + zone + "/max_energy_range_uj", range);
+            m_energy_sources.push_back({path, 1e-6});
+            m_energy_wrap_j.push_back(range * 1e-6);
+        }
+    }
+    if (!m_energy_sources.empty()) {
+        m_power_name = "RAPL (" + std::to_string(m_energy_sources.size()) + " package(s))";
+        return;
+    }
+
+    // Otherwise the first hwmon power sensor, microwatts. Boards expose
+    // different rails here, so only one is used to avoid double counting.
+    const std::string hwmon = "/sys/class/hwmon/";
+    for (const auto& dev : list_dir(hwmon, "hwmon")) {
+        for (const auto& input : list_dir(hwmon + dev, "power")) {
+            if (input.size() < 6 || input.compare(input.size() - 6, 6, "_input") != 0) {
+                continue;
+            }
+            std::string path = hwmon + dev + "/" + input;
+            if (read_value(path, value)) {
+                std::string name = read_line(hwmon + dev + "/name");
+                m_power_sensor = {path, 1e-6};
+                m_power_name = "hwmon " + (name.empty() ? dev : name) + "/" + input;
+                return;
+            }
+        }
+    }
+}
+
+void PowerMonitor::reset_energy() {
+    m_energy_j = 0.0;
+    m_last_time_ms = 0.0;
+
+    m_energy_last_j.assign(m_energy_sources.size(), kNaN);
+    for (size_t i = 0; i < m_energy_sources.size(); i++) {
+        double raw;
+        if (read_value(m_energy_sources[i].path, raw)) {
+            m_energy_last_j[i] = raw * m_energy_sources[i].scale;
+        }
+    }
+
+    m_last_power_w = kNaN;
+    double raw;
+    if (!m_power_sensor.path.empty() && read_value(m_power_sensor.path, raw)) {
+        m_last_power_w = raw * m_power_sensor.scale;
+    }
+}
+
+PowerSample PowerMonitor::take_sample() {
+    PowerSample sample;
+    sample.time_ms = elapsed_ms();
+    double raw;
+
+    sample.freq_mhz.reserve(m_freq_sources.size());
+    for (const auto& src : m_freq_sources) {
+        sample.freq_mhz.push_back(read_value(src.path, raw) ? raw * src.scale : kNaN);
+    }
+
+    sample.temp_c.reserve(m_temp_sources.size());
+    for (const auto& src : m_temp_sources) {
+        sample.temp_c.push_back(read_value(src.path, raw) ? raw * src.scale : kNaN);
+    }
+
+    // Cumulative counters: accumulate deltas, handling counter wrap-around
+    for (size_t i = 0; i < m_energy_sources.size(); i++) {
+        if (!read_value(m_energy_sources[i].path, raw)) {
+            continue;
+        }
+        double now_j = raw * m_energy_sources[i].scale;
+        if (!std::isnan(m_energy_last_j[i])) {
+            double delta = now_j - m_energy_last_j[i];
+            if (delta < 0.0) {
+                delta += m_energy_wrap_j[i];
+            }
+            m_energy_j += std::max(delta, 0.0);
+        }
+        m_energy_last_j[i] = now_j;
+    }
+
+    // Instantaneous power: trapezoidal integration between samples
+    if (!m_power_sensor.path.empty() && read_value(m_power_sensor.path, raw)) {
+        double power_w = raw * m_power_sensor.scale;
+        if (!std::isnan(m_last_power_w)) {
+            double dt_s = (sample.time_ms - m_last_time_ms) / 1000.0;
+            m_energy_j += 0.5 * (power_w + m_last_power_w) * dt_s;
+        }
+        m_last_power_w = power_w;
+    }
+
+    m_last_time_ms = sample.time_ms;
+    sample.energy_j = has_power() ? m_energy_j : kNaN;
+    return sample;
+}
+
+void PowerMonitor::start() {
+    stop();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_samples.clear();
+        m_start = std::chrono::steady_clock::now();
+        reset_energy();
+        m_samples.push_back(take_sample());
+        m_running = true;
+    }
+    m_thread = std::thread(&PowerMonitor::sample_loop, this);
+}
+
+void PowerMonitor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    // Close the window at the exact stop time
+    PowerSample last = take_sample();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples.push_back(std::move(last));
+}
+
+double PowerMonitor::elapsed_ms() const {
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000.0;
+}
+
+void PowerMonitor::sample_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        m_cv.wait_for(lock, std::chrono::milliseconds(m_interval_ms),
+                      [this] { return !m_running; });
+        if (!m_running) {
+            break;
+        }
+        // Don't hold the lock during sysfs reads
+        lock.unlock();
+        PowerSample sample = take_sample();
+        lock.lock();
+        m_samples.push_back(std::move(sample));
+    }
+}
+
+PowerSummary PowerMonitor::summarize(double from_ms, double to_ms) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<const PowerSample*> window;
+    for (const auto& s : m_samples) {
+        if (s.time_ms >= from_ms && (to_ms < 0.0 || s.time_ms <= to_ms)) {
+            window.push_back(&s);
+        }
+    }
+
+    PowerSummary summary;
+    size_t num_freq = m_freq_sources.size();
+    size_t num_temp = m_temp_sources.size();
+    summary.avg_freq_mhz.assign(num_freq, kNaN);
+    summary.min_freq_mhz.assign(num_freq, kNaN);
+    summary.max_freq_mhz.assign(num_freq, kNaN);
+    summary.throttle_events.assign(num_freq, 0);
+    summary.below_ceiling_pct.assign(num_freq, kNaN);
+    summary.avg_temp_c.assign(num_temp, kNaN);
+    summary.max_temp_c.assign(num_temp, kNaN);
+
+    if (window.empty()) {
+        return summary;
+    }
+    summary.duration_ms = window.back()->time_ms - window.front()->time_ms;
+
+    for (size_t d = 0; d < num_freq; d++) {
+        double sum = 0.0, lo = kNaN, hi = kNaN;
+        int count = 0;
+        for (const auto* s : window) {
+            double f = s->freq_mhz[d];
+            if (std::isnan(f)) continue;
+            sum += f;
+            count++;
+            lo = std::isnan(lo) ? f : std::min(lo, f);
+            hi = std::isnan(hi) ? f : std::max(hi, f);
+        }
+        if (count == 0) continue;
+        summary.avg_freq_mhz[d] = sum / count;
+        summary.min_freq_mhz[d] = lo;
+        summary.max_freq_mhz[d] = hi;
+
+        // Without an exposed ceiling, fall back to the peak seen in the window
+        double ceiling = std::isnan(m_freq_ceilings[d]) ? hi : m_freq_ceilings[d];
+        double threshold = kCeilingTolerance * ceiling;
+        bool below = false;
+        bool first = true;
+        double below_ms = 0.0;
+        const PowerSample* prev = nullptr;
+        for (const auto* s : window) {
+            double f = s->freq_mhz[d];
+            if (std::isnan(f)) continue;
+            // Attribute each interval to the state seen at its start
+            if (prev && below) {
+                below_ms += s->time_ms - prev->time_ms;
+            }
+            bool now_below = f < threshold;
+            if (now_below && (first || !below)) {
+                summary.throttle_events[d]++;
+            }
+            below = now_below;
+            first = false;
+            prev = s;
+        }
+        if (summary.duration_ms > 0.0) {
+            summary.below_ceiling_pct[d] = below_ms / summary.duration_ms * 100.0;
+        } else {
+            summary.below_ceiling_pct[d] = below ? 100.0 : 0.0;
+        }
+    }
+
+    for (size_t z = 0; z < num_temp; z++) {
+        double sum = 0.0, hi = kNaN;
+        int count = 0;
+        for (const auto* s : window) {
+            double t = s->temp_c[z];
+            if (std::isnan(t)) continue;
+            sum += t;
+            count++;
+            hi = std::isnan(hi) ? t : std::max(hi, t);
+        }
+        if (count == 0) continue;
+        summary.avg_temp_c[z] = sum / count;
+        summary.max_temp_c[z] = hi;
+    }
+
+    if (has_power() && window.size() >= 2 && summary.duration_ms > 0.0) {
+        summary.energy_j = window.back()->energy_j - window.front()->energy_j;
+        summary.avg_power_w = summary.energy_j / (summary.duration_ms / 1000.0);
+    }
+
+    return summary;
+}
@@ -0,0 +1,111 @@
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One reading of every source, taken on the sampling thread.
+// Values that could not be read are NaN.
+struct PowerSample {
+    double time_ms;                 // since start()
+    std::vector<double> freq_mhz;   // indexed like PowerMonitor::freq_domains()
+    std::vector<double> temp_c;     // indexed like PowerMonitor::thermal_zones()
+    double energy_j;                // cumulative since start(), NaN if no power source
+};
+
+struct PowerSummary {
+    double duration_ms = 0.0;
+    std::vector<double> avg_freq_mhz;
+    std::vector<double> min_freq_mhz;
+    std::vector<double> max_freq_mhz;
+    // Entries into running below the domain's ceiling (freq_ceilings()),
+    // counting a window that starts below it as one event
+    std::vector<int> throttle_events;
+    std::vector<double> below_ceiling_pct;  // share of the window below the ceiling
+    std::vector<double> avg_temp_c;
+    std::vector<double> max_temp_c;
+    double energy_j = -1.0;         // < 0 if no power source
+    double avg_power_w = -1.0;      // < 0 if no power source
+};
+
+// Samples cpufreq/devfreq frequencies, thermal zones and (where exposed)
+// RAPL energy counters or hwmon power sensors from sysfs on a background
+// thread. Sources are discovered once at construction; missing nodes are
+// simply skipped, so this runs (and reports nothing) on any Linux box.
+class PowerMonitor {
+public:
+    explicit PowerMonitor(int interval_ms = 100);
+    ~PowerMonitor();
+
+    PowerMonitor(const PowerMonitor&) = delete;
+    PowerMonitor& operator=(const PowerMonitor&) = delete;
+
+    // Clear previous samples and begin sampling
+    void start();
+    void stop();
+
+    // Milliseconds since start(), on the same clock as PowerSample::time_ms
+    double elapsed_ms() const;
+
+    // Aggregate samples in [from_ms, to_ms]; to_ms < 0 means "until stop()"
+    PowerSummary summarize(double from_ms = 0.0, double to_ms = -1.0) const;
+
+    const std::vector<std::string>& freq_domains() const { return m_freq_names; }
+    // Non-boost maximum per domain in MHz where exposed (NaN if none) and the
+    // governor active at construction (empty if not exposed)
+    const std::vector<double>& freq_ceilings() const { return m_freq_ceilings; }
+    const std::vector<std::string>& freq_governors() const { return m_freq_governors; }
+    // True where the only ceiling available is a boost (turbo) clock, which
+    // all-core load never sustains
+    const std::vector<bool>& ceiling_includes_boost() const { return m_freq_ceiling_boost; }
+    const std::vector<std::string>& thermal_zones() const { return m_temp_names; }
+    const std::string& power_source() const { return m_power_name; }
+    bool has_power() const { return !m_power_name.empty(); }
+
+private:
+    struct Source {
+        std::string path;
+        double scale;   // multiply the raw sysfs value to get MHz / degC / W / J
+    };
+
+    void discover();
+    void sample_loop();
+    void reset_energy();
+    PowerSample take_sample();
+
+    int m_interval_ms;
+
+    std::vector<Source> m_freq_sources;
+    std::vector<std::string> m_freq_names;
+    std::vector<double> m_freq_ceilings;
+    std::vector<std::string> m_freq_governors;
+    std::vector<bool> m_freq_ceiling_boost;
+    std::vector<Source> m_temp_sources;
+    std::vector<std::string> m_temp_names;
+
+    // Either cumulative energy counters (RAPL) or one instantaneous power sensor (hwmon)
+    std::vector<Source> m_energy_sources;
+    std::vector<double> m_energy_wrap_j;
+    Source m_power_sensor;
+    std::string m_power_name;
+
+    // Sampling state, only touched by whichever thread is currently sampling
+    std::vector<double> m_energy_last_j;
+    double m_last_power_w;
+    double m_energy_j;
+    double m_last_time_ms;
+
+    std::chrono::steady_clock::time_point m_start;
+    std::vector<PowerSample> m_samples;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+#endif // POWER_MONITOR_H
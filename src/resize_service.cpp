@@ -0,0 +1,125 @@
+#include "resize_service.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+ResizeService::ResizeService(std::vector<ResizeFn> workers, int num_streams, size_t queue_depth)
+    : m_workers(std::move(workers)), m_next_stream(0), m_pending(0),
+      m_sleepers(0), m_stopping(false) {
+    if (m_workers.empty()) {
+        throw std::invalid_argument("ResizeService needs at least one worker");
+    }
+    if (num_streams <= 0) {
+        throw std::invalid_argument("ResizeService needs at least one stream");
+    }
+
+    for (int i = 0; i < num_streams; i++) {
+        m_streams.push_back(std::make_unique<MPMCQueue<Job>>(std::max<size_t>(queue_depth, 2)));
+    }
+
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        m_threads.emplace_back(&ResizeService::worker_loop, this, i);
+    }
+}
+
+ResizeService::~ResizeService() {
+    shutdown();
+}
+
+std::future<double> ResizeService::submit(int stream_id, const float* input, float* output,
+                                          int input_width, int input_height,
+                                          int output_width, int output_height) {
+    if (stream_id < 0 || stream_id >= (int)m_streams.size()) {
+        throw std::out_of_range("Invalid stream id: " + std::to_string(stream_id));
+    }
+    if (m_stopping.load()) {
+        throw std::runtime_error("ResizeService is shut down");
+    }
+
+    Job job;
+    job.input = input;
+    job.output = output;
+    job.input_width = input_width;
+    job.input_height = input_height;
+    job.output_width = output_width;
+    job.output_height = output_height;
+    job.submitted = std::chrono::steady_clock::now();
+    std::future<double> result = job.done.get_future();
+
+    // A full per-stream queue is the backpressure signal: yield until a
+    // worker drains this stream rather than letting it crowd out others.
+    MPMCQueue<Job>& queue = *m_streams[stream_id];
+    while (!queue.try_push(std::move(job))) {
+        std::this_thread::yield();
+    }
+
+    m_pending.fetch_add(1);
+    if (m_sleepers.load() > 0) {
+        // Taking the lock orders us after a worker that has checked m_pending
+        // but not yet started waiting, so the notification cannot be lost.
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_cv.notify_one();
+
+    return result;
+}
+
+bool ResizeService::pop_next(Job& job) {
+    // Start each scan at the next stream in round-robin order so that every
+    // stream gets a turn regardless of how deep its queue is.
+    size_t num_streams = m_streams.size();
+    size_t start = m_next_stream.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < num_streams; i++) {
+        if (m_streams[(start + i) % num_streams]->try_pop(job)) {
+            m_pending.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResizeService::worker_loop(size_t worker_index) {
+    ResizeFn& resize = m_workers[worker_index];
+
+    for (;;) {
+        Job job;
+        if (pop_next(job)) {
+            try {
+                resize(job.input, job.output,
+                       job.input_width, job.input_height,
+                       job.output_width, job.output_height);
+                auto elapsed = std::chrono::steady_clock::now() - job.submitted;
+                job.done.set_value(
+                    std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000.0);
+            } catch (...) {
+                job.done.set_exception(std::current_exception());
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleepers.fetch_add(1);
+        m_cv.wait(lock, [this] { return m_pending.load() > 0 || m_stopping.load(); });
+        m_sleepers.fetch_sub(1);
+
+        // Drain everything already queued before exiting
+        if (m_stopping.load() && m_pending.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ResizeService::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping.load()) {
+            return;
+        }
+        m_stopping.store(true);
+    }
+    m_cv.notify_all();
+
+    for (auto& t : m_threads) {
+        if (t.joinable()) t.join();
+    }
+}
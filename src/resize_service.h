@@ -0,0 +1,80 @@
+#ifndef RESIZE_SERVICE_H
+#define RESIZE_SERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "mpmc_queue.h"
+
+// Thread-safe multi-stream resize service.
+//
+// Each worker thread owns one resize backend (e.g. an OpenCLResize with its
+// own command queue and cl_kernel), so backends are never called
+// concurrently. Producers push frames into a per-stream lock-free queue;
+// workers pick streams round-robin so a busy stream cannot starve the others.
+class ResizeService {
+public:
+    using ResizeFn = std::function<void(const float* input, float* output,
+                                        int input_width, int input_height,
+                                        int output_width, int output_height)>;
+
+    // One entry of `workers` per worker thread. `queue_depth` bounds the number
+    // of frames a single stream may have pending before submit() backs off;
+    // it is rounded up to a power of two, with a minimum of 2.
+    ResizeService(std::vector<ResizeFn> workers, int num_streams, size_t queue_depth = 8);
+    ~ResizeService();
+
+    ResizeService(const ResizeService&) = delete;
+    ResizeService& operator=(const ResizeService&) = delete;
+
+    // Queue a frame on `stream_id`. Safe to call from any thread. The future
+    // yields the end-to-end latency (submit to completion) in milliseconds,
+    // or rethrows the backend's exception.
+    std::future<double> submit(int stream_id, const float* input, float* output,
+                               int input_width, int input_height,
+                               int output_width, int output_height);
+
+    // Finish all queued frames and join the workers. Producers must have
+    // stopped submitting before this is called.
+    void shutdown();
+
+    int num_workers() const { return (int)m_threads.size(); }
+    int num_streams() const { return (int)m_streams.size(); }
+
+private:
+    struct Job {
+        const float* input = nullptr;
+        float* output = nullptr;
+        int input_width = 0;
+        int input_height = 0;
+        int output_width = 0;
+        int output_height = 0;
+        std::chrono::steady_clock::time_point submitted;
+        std::promise<double> done;
+    };
+
+    void worker_loop(size_t worker_index);
+    bool pop_next(Job& job);
+
+    std::vector<ResizeFn> m_workers;
+    std::vector<std::unique_ptr<MPMCQueue<Job>>> m_streams;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<size_t> m_next_stream;
+    std::atomic<int> m_pending;
+    std::atomic<int> m_sleepers;
+    std::atomic<bool> m_stopping;
+
+    // Only used to park idle workers; the submission path stays lock-free
+    // unless a worker is actually asleep.
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+#endif // RESIZE_SERVICE_H
@@ -3,6 +3,7 @@
 #include "sycl_resize.h"
 #include <iostream>
 #include <stdexcept>
+#include <utility>
 
 SYCLResize::SYCLResize() {
     try {
@@ -41,6 +42,23 @@ SYCLResize::SYCLResize() {
     }
 }
 
+SYCLResize::SYCLResize(std::unique_ptr<sycl::queue> queue)
+    : m_queue(std::move(queue)) {}
+
+std::unique_ptr<SYCLResize> SYCLResize::create_worker() const {
+    if (!m_queue) {
+        throw std::runtime_error("SYCL queue not initialized");
+    }
+    try {
+        auto queue = std::make_unique<sycl::queue>(
+            m_queue->get_context(), m_queue->get_device(),
+            sycl::property_list{sycl::property::queue::in_order()});
+        return std::unique_ptr<SYCLResize>(new SYCLResize(std::move(queue)));
+    } catch (const sycl::exception& e) {
+        throw std::runtime_error(std::string("SYCL worker queue creation failed: ") + e.what());
+    }
+}
+
 SYCLResize::~SYCLResize() {
     if (m_queue) {
         m_queue->wait();
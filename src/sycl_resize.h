@@ -11,11 +11,20 @@ public:
     SYCLResize();
     ~SYCLResize();
 
+    SYCLResize(const SYCLResize&) = delete;
+    SYCLResize& operator=(const SYCLResize&) = delete;
+
+    // Create a resizer with its own in-order queue on the same device and
+    // context, for driving the device from another thread.
+    std::unique_ptr<SYCLResize> create_worker() const;
+
     void resize(const float* input, float* output,
                int input_width, int input_height,
                int output_width, int output_height);
 
 private:
+    explicit SYCLResize(std::unique_ptr<sycl::queue> queue);
+
     std::unique_ptr<sycl::queue> m_queue;
 };
 
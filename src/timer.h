@@ -17,6 +17,13 @@ public:
         return duration.count() / 1000.0; // Return milliseconds
     }
 
+    // Milliseconds since start() without stopping; safe to call from several threads
+    double elapsed() const {
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - m_start);
+        return duration.count() / 1000.0;
+    }
+
 private:
     std::chrono::high_resolution_clock::time_point m_start;
     std::chrono::high_resolution_clock::time_point m_end;